@@ -0,0 +1,98 @@
+#include "allocstats.h"
+#include <QDebug>
+#include <cstdlib>
+#include <new>
+
+#ifdef QT_DEBUG
+
+static thread_local quint64 threadAllocations = 0;
+
+#if defined(__GLIBC__)
+// 替换glibc的malloc系列函数，Qt库中的分配也会经过这里
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    ++threadAllocations;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    ++threadAllocations;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    ++threadAllocations;
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+// 其他平台只能替换operator new（Qt容器直接使用malloc，不在统计范围内）
+void *operator new(std::size_t size)
+{
+    ++threadAllocations;
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    ++threadAllocations;
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    ++threadAllocations;
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+#endif
+
+quint64 allocationCount()
+{
+    return threadAllocations;
+}
+
+#else
+
+quint64 allocationCount()
+{
+    return 0;
+}
+
+#endif
+
+AllocFreeScope::AllocFreeScope(const char *name, bool enforce)
+    : name(name)
+    , enforce(enforce)
+    , start(allocationCount())
+{
+}
+
+AllocFreeScope::~AllocFreeScope()
+{
+    if (!enforce) return;
+    quint64 count = allocationCount() - start;
+    if (count > 0) {
+        qCritical() << name << "稳态帧中出现" << count << "次堆分配";
+        Q_ASSERT_X(false, name, "heap allocation in steady-state tick");
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <QtGlobal>
+
+// 调试版本中统计当前线程的堆分配次数，用于检查稳态帧是否零分配
+// Linux(glibc)下统计所有malloc/calloc/realloc（包括Qt容器）；其他平台只统计operator new
+// 发布版本不做统计，始终返回0
+quint64 allocationCount();
+
+// 检查作用域内没有堆分配；enforce为false时（如预热阶段）不检查
+class AllocFreeScope
+{
+public:
+    AllocFreeScope(const char *name, bool enforce);
+    ~AllocFreeScope();
+
+private:
+    const char *name;
+    bool enforce;
+    quint64 start;
+};
+
+// 统计作用域内的堆分配次数（只记录不检查），用于观察仍在Qt内部分配的调用
+class AllocMeter
+{
+public:
+    AllocMeter() : start(allocationCount()) {}
+    quint64 count() const { return allocationCount() - start; }
+
+private:
+    quint64 start;
+};
+
+#endif // ALLOCSTATS_H
@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,11 +9,25 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    allocstats.cpp \
+    carview.cpp \
+    frametext.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    routelibrary.cpp \
+    simulator.cpp \
+    telemetry.cpp \
+    tuner.cpp
 
 HEADERS += \
-    mainwindow.h
+    allocstats.h \
+    carview.h \
+    frametext.h \
+    mainwindow.h \
+    routelibrary.h \
+    simulator.h \
+    telemetry.h \
+    tuner.h
 
 FORMS += \
     mainwindow.ui
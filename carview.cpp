@@ -0,0 +1,174 @@
+#include "carview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygonF>
+#include <QPen>
+#include <QFont>
+#include <cmath>
+#include "allocstats.h"
+
+CarView::CarView(QWidget *parent)
+    : QWidget(parent)
+    , routePen(QColor(200, 200, 200, 150), 1) // 规划路径使用淡灰色（半透明）
+    , trajectoryPen(Qt::green, 2)
+    , outlinePen(Qt::black, 1)
+    , borderPen(Qt::darkGray, 2)
+    , textPen(Qt::black)
+    , bodyBrush(QColor(100, 150, 255))
+    , headBrush(Qt::red)
+    , cornerFont("Arial", 10)
+{
+    // 每帧整幅重绘，不需要Qt先擦除背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void CarView::setCar(const QPointF &pos, double direction)
+{
+    carPosition = pos;
+    carDirection = direction;
+}
+
+void CarView::setTrajectory(const QVector<QPointF> *points)
+{
+    trajectory = points;
+}
+
+void CarView::setTrajectoryColor(const QColor &color)
+{
+    // 颜色只在切换模式时变化，相同时不修改画笔（避免共享数据分离）
+    if (trajectoryColor == color) return;
+    trajectoryColor = color;
+    trajectoryPen.setColor(color);
+}
+
+void CarView::setRoute(const QVector<QPointF> *points)
+{
+    route = points;
+    routeDirty = true;
+}
+
+void CarView::setRouteVisible(bool visible)
+{
+    routeVisible = visible;
+}
+
+void CarView::setAntialiasing(bool enabled)
+{
+    if (antialiasing == enabled) return;
+    antialiasing = enabled;
+    routeDirty = true;
+}
+
+void CarView::rebuildRouteCache()
+{
+    routeDirty = false;
+    routeCache = QPixmap();
+    routeDirect = false;
+    if (!route || route->size() < 2) return;
+
+    // 路线范围（留出线宽边距）
+    QRectF bounds = QPolygonF(*route).boundingRect().adjusted(-2, -2, 2, 2);
+    routeCacheOrigin = bounds.topLeft();
+
+    // 路线太大时不缓存（大图路线的位图会占用上百MB），改为每帧直接绘制
+    qreal dpr = devicePixelRatioF();
+    qreal cachePixels = std::ceil(bounds.width() * dpr) * std::ceil(bounds.height() * dpr);
+    if (cachePixels > MAX_CACHE_PIXELS) {
+        routeDirect = true;
+        return;
+    }
+
+    routeCache = QPixmap(std::ceil(bounds.width() * dpr), std::ceil(bounds.height() * dpr));
+    routeCache.setDevicePixelRatio(dpr);
+    routeCache.fill(Qt::transparent);
+
+    QPainter painter(&routeCache);
+    painter.setRenderHint(QPainter::Antialiasing, antialiasing);
+    painter.translate(-routeCacheOrigin);
+    // 规划路径使用淡灰色（半透明），闭合路径
+    painter.setPen(routePen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPolygon(route->constData(), route->size());
+}
+
+void CarView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    AllocMeter meter;
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    painter.setRenderHint(QPainter::Antialiasing, antialiasing);
+
+    // 视图中心跟随小车（与QGraphicsView::centerOn一致）
+    painter.save();
+    painter.translate(width() / 2.0 - carPosition.x(), height() / 2.0 - carPosition.y());
+
+    // 规划路线（位图缓存，路线过大时直接绘制）
+    if (routeVisible && route) {
+        if (routeDirty) rebuildRouteCache();
+        if (routeDirect) {
+            painter.setPen(routePen);
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPolygon(route->constData(), route->size());
+        } else if (!routeCache.isNull()) {
+            painter.drawPixmap(routeCacheOrigin, routeCache);
+        }
+    }
+
+    // 已移动轨迹（一次drawPolyline）
+    if (trajectory && trajectory->size() > 1) {
+        painter.setPen(trajectoryPen);
+        painter.drawPolyline(trajectory->constData(), trajectory->size());
+    }
+
+    // 小车车身和车头指示器
+    painter.translate(carPosition);
+    painter.rotate(carDirection);
+    painter.setPen(outlinePen);
+    painter.setBrush(bodyBrush);
+    painter.drawRect(QRectF(-CAR_LENGTH/2, -CAR_WIDTH/2, CAR_LENGTH, CAR_WIDTH));
+
+    const QPointF head[3] = {
+        QPointF(CAR_LENGTH/2, 0),
+        QPointF(CAR_LENGTH/2 - 20, -10),
+        QPointF(CAR_LENGTH/2 - 20, 10)
+    };
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(headBrush);
+    painter.drawPolygon(head, 3);
+    painter.restore();
+
+    // 视图边框
+    painter.setPen(borderPen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(QRectF(rect()).adjusted(1, 1, -1, -1));
+
+    // 四个角的坐标标签（写入预分配的缓冲区）
+    const int padding = 5;
+    QRectF viewRect(carPosition.x() - width() / 2.0, carPosition.y() - height() / 2.0, width(), height());
+    const QPointF corners[4] = { viewRect.topLeft(), viewRect.topRight(), viewRect.bottomLeft(), viewRect.bottomRight() };
+    {
+        AllocFreeScope scope("CarView::paintEvent", allocationChecks);
+        for (int i = 0; i < 4; i++) {
+            cornerText[i].begin()
+                .append(QLatin1String("(")).appendNumber(corners[i].x(), 0)
+                .append(QLatin1String(", ")).appendNumber(corners[i].y(), 0)
+                .append(QLatin1String(")"));
+        }
+    }
+
+    static const int alignments[4] = {
+        Qt::AlignLeft | Qt::AlignTop, Qt::AlignRight | Qt::AlignTop,
+        Qt::AlignLeft | Qt::AlignBottom, Qt::AlignRight | Qt::AlignBottom
+    };
+    QRectF textRect = QRectF(rect()).adjusted(padding, padding, -padding, -padding);
+    painter.setFont(cornerFont);
+    painter.setPen(textPen);
+    for (int i = 0; i < 4; i++) {
+        painter.drawText(textRect, alignments[i], cornerText[i].text());
+    }
+    painter.end();
+
+    lastPaintAllocations = meter.count();
+}
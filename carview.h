@@ -0,0 +1,84 @@
+#ifndef CARVIEW_H
+#define CARVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QPointF>
+#include <QPixmap>
+#include <QColor>
+#include <QPen>
+#include <QBrush>
+#include <QFont>
+#include "frametext.h"
+
+// 不依赖QGraphicsScene的小车视图：直接读取模拟数据（轨迹/路线）用QPainter绘制
+// 静态路线缓存为位图，轨迹用drawPolyline批量绘制，不做图元索引
+class CarView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CarView(QWidget *parent = nullptr);
+
+    // 小车位姿（中心点坐标，角度）
+    void setCar(const QPointF &pos, double direction);
+
+    // 已移动轨迹（只保存指针，绘制时直接读取模拟缓冲区）
+    void setTrajectory(const QVector<QPointF> *points);
+    void setTrajectoryColor(const QColor &color);
+
+    // 规划路线（路线点变化后需调用，使位图缓存失效）
+    void setRoute(const QVector<QPointF> *points);
+    void setRouteVisible(bool visible);
+
+    void setAntialiasing(bool enabled);
+
+    // 是否检查文本格式化中的堆分配（预热结束后开启）
+    void setAllocationChecks(bool enabled) { allocationChecks = enabled; }
+    // 上一次paintEvent中的堆分配次数（调试版本统计，包括QPainter内部的分配）
+    quint64 paintAllocations() const { return lastPaintAllocations; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    // 重新生成路线位图缓存
+    void rebuildRouteCache();
+
+    QPointF carPosition;
+    double carDirection = 0;
+
+    const QVector<QPointF> *trajectory = nullptr;
+    QColor trajectoryColor = Qt::green;
+
+    const QVector<QPointF> *route = nullptr;
+    bool routeVisible = false;
+    bool routeDirty = true;
+    QPixmap routeCache;
+    QPointF routeCacheOrigin; // 位图左上角对应的场景坐标
+    bool routeDirect = false; // 路线过大，不缓存而直接绘制
+    QPen routePen;
+
+    // 每帧使用的画笔、画刷和字体（只创建一次）
+    QPen trajectoryPen;
+    QPen outlinePen;
+    QPen borderPen;
+    QPen textPen;
+    QBrush bodyBrush;
+    QBrush headBrush;
+    QFont cornerFont;
+    FrameText cornerText[4]; // 四个角的坐标文本
+
+    bool allocationChecks = false;
+    quint64 lastPaintAllocations = 0;
+
+    // 路线位图缓存的像素上限（约16MB），超过则直接绘制
+    const qreal MAX_CACHE_PIXELS = 2048.0 * 2048.0;
+
+    bool antialiasing = true;
+
+    const double CAR_LENGTH = 60.0; // 小车长度（像素）
+    const double CAR_WIDTH = 30.0;  // 小车宽度
+};
+
+#endif // CARVIEW_H
@@ -0,0 +1,70 @@
+#include "frametext.h"
+#include <cstdio>
+#include <cmath>
+
+FrameText::FrameText(int capacity)
+{
+    buffers[0].reserve(capacity);
+    buffers[1].reserve(capacity);
+}
+
+FrameText &FrameText::begin()
+{
+    // 另一块缓冲没有被其他QString共享时才切换
+    if (buffers[current ^ 1].isDetached()) current ^= 1;
+    buffers[current].resize(0); // 只清空内容，不释放容量
+    return *this;
+}
+
+FrameText &FrameText::append(const QString &text)
+{
+    buffers[current].append(text);
+    return *this;
+}
+
+FrameText &FrameText::append(QLatin1String text)
+{
+    buffers[current].append(text);
+    return *this;
+}
+
+FrameText &FrameText::appendNumber(double value, int decimals)
+{
+    // 手工格式化到栈上（不经过printf，小数点不受LC_NUMERIC影响），再追加到已分配的缓冲区
+    // 适用于界面显示的坐标/速度等数值（|value| < 1e15）
+    if (std::isnan(value)) return append(QLatin1String("nan"));
+    if (std::isinf(value)) return append(QLatin1String(value < 0 ? "-inf" : "inf"));
+
+    decimals = qBound(0, decimals, 9);
+    unsigned long long scale = 1;
+    for (int i = 0; i < decimals; i++) scale *= 10;
+    double scaled = std::fabs(value) * scale;
+    if (scaled >= 9e18) return append(QLatin1String(value < 0 ? "-inf" : "inf"));
+    unsigned long long rounded = static_cast<unsigned long long>(std::llround(scaled));
+
+    // 从个位开始倒序写入
+    char digits[32];
+    int pos = sizeof(digits);
+    for (int i = 0; i < decimals; i++) {
+        digits[--pos] = char('0' + rounded % 10);
+        rounded /= 10;
+    }
+    if (decimals > 0) digits[--pos] = '.';
+    do {
+        digits[--pos] = char('0' + rounded % 10);
+        rounded /= 10;
+    } while (rounded > 0);
+    if (value < 0 && scaled >= 0.5) digits[--pos] = '-'; // 舍入为0时不输出"-0"
+
+    buffers[current].append(QLatin1String(digits + pos, int(sizeof(digits)) - pos));
+    return *this;
+}
+
+FrameText &FrameText::appendNumber(int value)
+{
+    // 整数不带千位分隔符，printf的%d不受区域设置影响
+    char digits[16];
+    int length = std::snprintf(digits, sizeof(digits), "%d", value);
+    if (length > 0) buffers[current].append(QLatin1String(digits, qMin(length, int(sizeof(digits)) - 1)));
+    return *this;
+}
@@ -0,0 +1,30 @@
+#ifndef FRAMETEXT_H
+#define FRAMETEXT_H
+
+#include <QString>
+#include <QLatin1String>
+
+// 预分配的逐帧文本缓冲：每帧重用已有容量拼接文本，不产生堆分配
+// 两块缓冲交替使用：控件（QLabel等）引用其中一块时，写入另一块，避免共享数据被修改时重新分配
+class FrameText
+{
+public:
+    explicit FrameText(int capacity = 128);
+
+    // 开始新一帧的文本：切换到未被引用的缓冲区并清空（保留容量）
+    FrameText &begin();
+
+    FrameText &append(const QString &text);
+    FrameText &append(QLatin1String text);
+    // 数值格式与区域设置无关（小数点始终为'.'）
+    FrameText &appendNumber(double value, int decimals);
+    FrameText &appendNumber(int value);
+
+    const QString &text() const { return buffers[current]; }
+
+private:
+    QString buffers[2];
+    int current = 0;
+};
+
+#endif // FRAMETEXT_H
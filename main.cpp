@@ -1,12 +1,34 @@
 #include "mainwindow.h"
+#include "tuner.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // 无界面参数调优：autoDrive --tune grid|random|es [选项]
+    for (int i = 1; i < argc; i++) {
+        QString arg(argv[i]);
+        if (arg == "--tune" || arg.startsWith("--tune=")) {
+            QCoreApplication a(argc, argv);
+            return runTuner(a.arguments());
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.setWindowTitle("Qt6 自动驾驶模拟器");
     w.resize(1000, 700);
     w.show();
+
+    // 纯CPU渲染的设备上可关闭抗锯齿：autoDrive --no-antialiasing
+    if (a.arguments().contains("--no-antialiasing")) {
+        w.setAntialiasing(false);
+    }
+
+    // 渲染性能对比：autoDrive --bench-render（不启动遥测服务）
+    if (a.arguments().contains("--bench-render")) {
+        w.benchmarkRenderers(3000);
+        return 0;
+    }
+    w.startTelemetry();
     return a.exec();
 }
\ No newline at end of file
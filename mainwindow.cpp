@@ -12,7 +12,10 @@
 #include <QPainterPath>
 #include <QResource>
 #include <QDir>
-#include <cmath>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <algorithm>
+#include "allocstats.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -22,6 +25,7 @@ MainWindow::MainWindow(QWidget *parent)
     
     // 初始化场景
     scene = new QGraphicsScene(this);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex); // 图元每帧都在移动，不建BSP索引
     ui->graphicsView->setScene(scene);
     ui->graphicsView->setRenderHint(QPainter::Antialiasing); // 抗锯齿
     ui->graphicsView->setFrameShape(QFrame::NoFrame); // 移除默认边框
@@ -52,8 +56,10 @@ MainWindow::MainWindow(QWidget *parent)
     carGroup->setPos(carPosition);
     carGroup->setRotation(carDirection);
     
-    // 初始化轨迹点
+    // 初始化轨迹点（预留容量，运行中不再重新分配）
+    trajectory.reserve(TRAJECTORY_LIMIT);
     trajectory.append(carPosition);
+    createScenePools();
     
     // 连接按钮信号
     connect(ui->btnLeft, &QPushButton::pressed, this, &MainWindow::onLeftPressed);
@@ -65,6 +71,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnFigureHandWrite, &QPushButton::pressed, this, &MainWindow::onFigureHandWritePressed); // 8字形按钮
     connect(ui->loadButton, &QPushButton::clicked, this, &MainWindow::loadImage);
     connect(ui->initButton, &QPushButton::clicked, this, &MainWindow::onInitPressed);
+    connect(ui->btnRenderer, &QPushButton::clicked, this, &MainWindow::onRendererPressed);
+    connect(ui->routeCombo, &QComboBox::currentIndexChanged, this, &MainWindow::onRouteSelected);
+    ui->graphicsView_2->viewport()->installEventFilter(this);
 
     // 按钮释放连接
     connect(ui->btnLeft, &QPushButton::released, this, &MainWindow::releaseControls);
@@ -72,6 +81,18 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnAccel, &QPushButton::released, this, &MainWindow::releaseControls);
     connect(ui->btnDecel, &QPushButton::released, this, &MainWindow::releaseControls);
     
+    // 创建自绘视图（与graphicsView同位置，默认隐藏）
+    carView = new CarView(ui->centralwidget);
+    carView->setGeometry(ui->graphicsView->geometry());
+    carView->setTrajectory(&trajectory);
+    carView->setRoute(&figurePoints);
+    carView->hide();
+
+    // 启动遥测服务
+    // 遥测服务在startTelemetry()中开始监听
+    telemetry = new TelemetryServer(this);
+    connect(telemetry, &TelemetryServer::commandReceived, this, &MainWindow::onTelemetryCommand);
+
     // 初始化定时器（更新频率30Hz）
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &MainWindow::updateCarPosition);
@@ -114,6 +135,27 @@ MainWindow::MainWindow(QWidget *parent)
     updateSceneRect();
 }
 
+void MainWindow::createScenePools()
+{
+    // 轨迹线段（最多TRAJECTORY_LIMIT-1段），初始隐藏
+    trajectoryColor = Qt::green;
+    QPen pen(trajectoryColor, 2);
+    for (int i = 1; i < TRAJECTORY_LIMIT; i++) {
+        QGraphicsLineItem *line = scene->addLine(QLineF(), pen);
+        line->setZValue(-1); // 置于底层
+        line->setVisible(false);
+        trajectoryItems.append(line);
+    }
+
+    // 规划路径使用淡灰色（半透明）
+    figurePathItem = new QGraphicsPathItem();
+    figurePathItem->setPen(QPen(QColor(200, 200, 200, 150), 1));
+    figurePathItem->setBrush(Qt::NoBrush);
+    figurePathItem->setZValue(-2); // 在轨迹之下
+    figurePathItem->setVisible(false);
+    scene->addItem(figurePathItem);
+}
+
 void MainWindow::onInitPressed()
 {
     driveMode = manualMode;
@@ -127,9 +169,7 @@ void MainWindow::onInitPressed()
 void MainWindow::updateSceneRect()
 {
     // 获取当前视图范围
-    QRectF viewRect = ui->graphicsView->mapToScene(
-        ui->graphicsView->viewport()->rect()
-    ).boundingRect();
+    QRectF viewRect = visibleSceneRect();
     
     // 计算新的场景范围（比视图范围大一些）
     double padding = 500; // 场景边界留白
@@ -208,16 +248,17 @@ void MainWindow::onFigure8Pressed()
     // 以当前小车位置为起点，当前方向为起始方向生成8字形
     generateFigure8();
     
-    figureIndex = 1;
-    carSpeed = 5; // 设置固定速度
+    figureIndex = 0; // 从路线起点开始跟踪，由控制器加速到目标速度
 }
 
 void MainWindow::onFigureHandWritePressed()
 {
     driveMode = figureHandWriteMode; // 切换手写模式
+
+    // 以小车当前位置和方向重新放置路线（选择路线后小车可能已经移动）
+    adjustFigure();
     
-    figureIndex = 1;
-    carSpeed = 5; // 设置固定速度
+    figureIndex = 0; // 从路线起点开始跟踪，由控制器加速到目标速度
 }
 
 void MainWindow::releaseControls()
@@ -230,22 +271,8 @@ void MainWindow::releaseControls()
 
 void MainWindow::generateFigure8()
 {
-    // 生成8字形轨迹点（参数方程）
-    int totalPoints = 200; // 总点数
-    figurePoints.clear();
-
-    // 标准8字形参数方程（以原点为中心）
-    for(int i = 0; i < totalPoints; i++) {
-        double t = 2.0 * M_PI * i / totalPoints;
-        double x_orig = figure8Size * sin(t) / (1 + pow(cos(t), 2));
-        double y_orig = figure8Size * sin(t) * cos(t) / (1 + pow(cos(t), 2));
-        figurePoints.append(QPointF(x_orig, y_orig));
-
-        // 应用旋转（使曲线在t=0时与x轴相切）
-        // double x = x_orig * cos(roAngle) - y_orig * sin(roAngle);
-        // double y = x_orig * sin(roAngle) + y_orig * cos(roAngle);
-        // figurePoints.append(QPointF(x, y));
-    }
+    // 生成8字形轨迹点（参数方程，200个点）
+    figurePoints = Simulator::figure8Points(figure8Size);
 
     displayPoints();
     adjustFigure();
@@ -253,6 +280,14 @@ void MainWindow::generateFigure8()
 
 void MainWindow::adjustFigure()
 {
+    if (figurePoints.size() < 2) return;
+
+    // 先把起点平移到原点（图片路线的坐标以图片左上角为原点）
+    QPointF origin = figurePoints[0];
+    for(int i = 0; i < figurePoints.size(); i++) {
+        figurePoints[i] -= origin;
+    }
+
     double dx = figurePoints[1].x() - figurePoints[0].x();
     double dy = figurePoints[1].y() - figurePoints[0].y();
     
@@ -283,77 +318,173 @@ void MainWindow::adjustFigure()
     for(int i = 0; i < figurePoints.size(); i++) {
         figurePoints[i] = transform.map(figurePoints[i]);
     }
+
+    // 路线已改变，刷新自绘视图的路线缓存和场景中的规划路径
+    carView->setRoute(&figurePoints);
+    figurePathDirty = true;
 }
 
 void MainWindow::updateCarPosition()
 {
-    switch (driveMode)
+    tickCount++;
+    AllocMeter tickMeter; // 整帧的堆分配（包括Qt内部），只记录不检查
+
+    // 运动计算和轨迹记录（稳态下不允许堆分配）
     {
-    case figure8Mode:
-        if(figureIndex < figurePoints.size()) {
-            // 获取下一个8字形点
-            QPointF nextPos = figurePoints[figureIndex];
-            
-            // 计算方向变化（基于当前位置和下一位置）
-            double dx = nextPos.x() - carPosition.x();
-            double dy = nextPos.y() - carPosition.y();
-            carDirection = qRadiansToDegrees(std::atan2(dy, dx));
-            
-            // 更新位置
-            carPosition = nextPos;
-            figureIndex++;
-            
-            // 如果到达终点，回到起点
-            if(figureIndex >= figurePoints.size()) {
-                figureIndex = 0;
-            }
+        AllocFreeScope scope("updateCarPosition", isSteadyState());
+        stepMotion();
+        recordTrajectory();
+    }
+    if (routeAborted) {
+        routeAborted = false;
+        ui->statusbar->showMessage(QString("偏离路线超过%1像素，已停车并切换到手动模式")
+                                   .arg(Simulator::ABORT_ERROR), ABORT_MESSAGE_MS);
+    }
+    
+    if (useCarView) {
+        // 自绘视图直接读取轨迹和路线缓冲区，只需更新小车位姿
+        {
+            AllocFreeScope scope("CarView tick", isSteadyState());
+            carView->setCar(carPosition, carDirection);
+            carView->setTrajectoryColor(driveMode ? Qt::gray : Qt::green);
+            carView->setRouteVisible(driveMode);
+            carView->setAllocationChecks(isSteadyState());
         }
-        break;
-    case figureHandWriteMode:
-        if(figureIndex < figurePoints.size()) {
-            // 获取下一个点
-            QPointF nextPos = figurePoints[figureIndex];
-            
-            // 计算方向变化（基于当前位置和下一位置）
-            double dx = nextPos.x() - carPosition.x();
-            double dy = nextPos.y() - carPosition.y();
-            carDirection = qRadiansToDegrees(std::atan2(dy, dx));
-            
-            // 更新位置
-            carPosition = nextPos;
-            figureIndex++;
-            
-            // 如果到达终点，回到起点
-            if(figureIndex >= figurePoints.size()) {
+        carView->update();
+    } else {
+        updateSceneView();
+        if (tickCount % 3 == 0) drawTrajectory();
+    }
+    
+    // 更新状态显示
+    updateStatusDisplay();
+
+    publishTelemetry();
+
+#ifdef QT_DEBUG
+    // 定期输出仍在Qt内部发生的堆分配次数（绘制在事件循环中进行，统计的是上一次paintEvent）
+    if (isSteadyState() && tickCount % ALLOC_LOG_INTERVAL == 0) {
+        quint64 tickAllocations = tickMeter.count();
+        if (useCarView) {
+            qDebug() << "每帧堆分配: updateCarPosition" << tickAllocations
+                     << "CarView::paintEvent" << carView->paintAllocations();
+        } else {
+            qDebug() << "每帧堆分配: updateCarPosition" << tickAllocations;
+        }
+    }
+#endif
+}
+
+void MainWindow::recordTrajectory()
+{
+    // 记录轨迹（每3帧记录一次）
+    if (tickCount % 3 != 0) return;
+
+    if (trajectory.size() >= TRAJECTORY_LIMIT) {
+        // 轨迹已满：整体前移一位，覆盖最旧的点（容量已预留，不重新分配）
+        std::copy(trajectory.begin() + 1, trajectory.end(), trajectory.begin());
+        trajectory.last() = carPosition;
+    } else {
+        trajectory.append(carPosition);
+    }
+}
+
+void MainWindow::stepMotion()
+{
+    // 与调参程序相同的运动学和预瞄控制器（Simulator）
+    VehicleState state;
+    state.position = carPosition;
+    state.direction = carDirection;
+    state.speed = carSpeed;
+    state.index = figureIndex;
+
+    if (driveMode != manualMode && figurePoints.size() >= 2) {
+        double error = Simulator::updateNearest(state, figurePoints);
+        if (error > Simulator::ABORT_ERROR) {
+            // 偏离路线太远（调参时视为失败），停车并切换到手动模式
+            driveMode = manualMode;
+            state.speed = 0;
+            routeAborted = true; // 提示在零分配检查范围之外显示
+        } else if (state.index >= figurePoints.size() - 1) {
+            if (driveMode == figure8Mode) {
+                // 8字形到达终点，回到起点继续
+                state.index = 0;
+                Simulator::controlStep(state, figurePoints, params);
+            } else {
+                // 手写路线走完，停车
                 driveMode = manualMode;
-                carSpeed = 0;
+                state.speed = 0;
             }
+        } else {
+            Simulator::controlStep(state, figurePoints, params);
         }
-        break;
-    default:
+    } else {
         // 手动模式
         // 转向控制（左右转向）
-        if (leftPressed) carDirection -= 2.0;  // 左转
-        if (rightPressed) carDirection += 2.0; // 右转
+        if (leftPressed) state.direction -= params.turnStep;  // 左转
+        if (rightPressed) state.direction += params.turnStep; // 右转
         
         // 速度控制（加速/减速）
-        if (accelPressed) carSpeed += 0.2;
-        if (decelPressed) carSpeed -= 0.2;
-        if (carSpeed < 0) carSpeed = 0; // 最低速度为0
-        
-        // 限制最大速度
-        if (carSpeed > 10) carSpeed = 10;
-        
-        // 计算位移增量（极坐标转换）
-        double rad = qDegreesToRadians(carDirection);
-        double dx = carSpeed * cos(rad);
-        double dy = carSpeed * sin(rad);
-        
-        // 更新位置
-        carPosition += QPointF(dx, dy);
+        if (accelPressed) state.speed += params.accelStep;
+        if (decelPressed) state.speed -= params.accelStep;
+        state.speed = qBound(0.0, state.speed, params.maxSpeed); // 速度范围[0, maxSpeed]
+
+        Simulator::move(state);
+    }
+
+    carPosition = state.position;
+    carDirection = state.direction;
+    carSpeed = state.speed;
+    figureIndex = state.index;
+}
+
+void MainWindow::publishTelemetry()
+{
+    TelemetryFrame frame;
+    frame.magic = TELEMETRY_MAGIC;
+    frame.version = TELEMETRY_VERSION;
+    frame.size = sizeof(TelemetryFrame);
+    frame.tick = tickCount;
+    frame.x = carPosition.x();
+    frame.y = carPosition.y();
+    frame.direction = carDirection;
+    frame.speed = carSpeed;
+    frame.mode = driveMode;
+    frame.routeIndex = figureIndex;
+    frame.routeSize = figurePoints.size();
+    telemetry->publish(frame);
+}
+
+void MainWindow::onTelemetryCommand(quint16 code)
+{
+    switch (code)
+    {
+    case cmdLeft:
+        onLeftPressed();
+        break;
+    case cmdRight:
+        onRightPressed();
+        break;
+    case cmdAccel:
+        onAccelPressed();
+        break;
+    case cmdDecel:
+        onDecelPressed();
+        break;
+    case cmdRelease:
+        releaseControls();
+        break;
+    case cmdBrake:
+        onBrakePressed();
+        break;
+    default:
+        qDebug() << "未知遥测命令:" << code;
         break;
     }
-    
+}
+
+void MainWindow::updateSceneView()
+{
     // 更新小车位置和方向
     carGroup->setPos(carPosition);
     carGroup->setRotation(carDirection);
@@ -367,97 +498,147 @@ void MainWindow::updateCarPosition()
     // 更新坐标标签和边框
     updateCornerCoordinates();
     updateViewBorder();
-    
-    // 记录轨迹（每3帧记录一次）
-    static int counter = 0;
-    if (++counter % 3 == 0) {
-        trajectory.append(carPosition);
-        if (trajectory.size() > 200) trajectory.removeFirst(); // 限制轨迹点数
+}
+
+void MainWindow::onRendererPressed()
+{
+    setCarViewEnabled(!useCarView);
+}
+
+void MainWindow::setCarViewEnabled(bool enabled)
+{
+    useCarView = enabled;
+    ui->graphicsView->setVisible(!useCarView);
+    carView->setVisible(useCarView);
+    ui->btnRenderer->setText(useCarView ? "场景渲染" : "自绘渲染");
+
+    if (useCarView) {
+        carView->setCar(carPosition, carDirection);
+        carView->setTrajectoryColor(driveMode ? Qt::gray : Qt::green);
+        carView->setRouteVisible(driveMode);
+        carView->update();
+    } else {
+        // 切回场景视图时同步场景内容
+        updateSceneView();
         drawTrajectory();
     }
-    
-    // 更新状态显示
-    updateStatusDisplay();
 }
 
-void MainWindow::drawTrajectory()
+void MainWindow::startTelemetry()
+{
+    telemetry->listen("autoDrive-telemetry");
+}
+
+void MainWindow::setAntialiasing(bool enabled)
 {
-    // 清除全部旧轨迹
-    QList<QGraphicsItem*> items = scene->items();
-    for (QGraphicsItem *item : items) {
-        if (item->data(0).toString() == "trajectory" || 
-            item->data(0).toString() == "figure8_path") {
-            scene->removeItem(item);
-            delete item;
+    // 同时作用于场景视图和自绘视图（显示框B不受影响）
+    antialiasing = enabled;
+    ui->graphicsView->setRenderHint(QPainter::Antialiasing, enabled);
+    carView->setAntialiasing(enabled);
+}
+
+void MainWindow::benchmarkRenderers(int frames)
+{
+    timer->stop();
+    bool wasCarView = useCarView;
+    bool wasAntialiasing = antialiasing;
+
+    // 两种渲染方式 × 是否抗锯齿，跑相同的8字形路线
+    // 每帧：updateCarPosition + 处理事件队列（场景变更通知、脏区域合并）+ 同步重绘屏幕上的控件
+    for (int pass = 0; pass < 4; pass++) {
+        setCarViewEnabled(pass >= 2);
+        setAntialiasing(pass % 2 == 0);
+        onInitPressed();
+        onFigure8Pressed();
+        QCoreApplication::processEvents(); // 排空切换视图产生的事件，不计入耗时
+
+        QWidget *target = useCarView ? static_cast<QWidget *>(carView) : ui->graphicsView->viewport();
+        QElapsedTimer elapsed;
+        elapsed.start();
+        for (int i = 0; i < frames; i++) {
+            updateCarPosition();
+            QCoreApplication::processEvents();
+            target->repaint();
         }
+        qint64 ms = elapsed.elapsed();
+        qDebug() << (useCarView ? "CarView" : "QGraphicsView")
+                 << (antialiasing ? "抗锯齿" : "无抗锯齿")
+                 << frames << "帧耗时" << ms << "ms,"
+                 << "平均" << double(ms) / frames << "ms/帧"
+                 << "（屏幕重绘：updateCarPosition + processEvents + repaint）";
     }
-    
-    // 绘制新轨迹
-    QPen pen;
-    if(driveMode) {
-        pen.setColor(Qt::gray);  // 自动轨迹
-    } else {
-        pen.setColor(Qt::green);  // 手动轨迹
+
+    setCarViewEnabled(wasCarView);
+    setAntialiasing(wasAntialiasing);
+    timer->start(33);
+}
+
+void MainWindow::drawTrajectory()
+{
+    // 轨迹颜色：自动模式灰色，手动模式绿色（颜色改变时才更新画笔）
+    QColor color = driveMode ? Qt::gray : Qt::green;
+    if (color != trajectoryColor) {
+        trajectoryColor = color;
+        QPen pen(trajectoryColor, 2);
+        for (QGraphicsLineItem *line : std::as_const(trajectoryItems)) {
+            line->setPen(pen);
+        }
     }
-    pen.setWidth(2);
-    pen.setStyle(Qt::SolidLine);
     
-    // 小车200个点的已移动轨迹
-    for (int i = 1; i < trajectory.size(); i++) {
-        QGraphicsLineItem *line = scene->addLine(
-            trajectory[i-1].x(), trajectory[i-1].y(),
-            trajectory[i].x(), trajectory[i].y(), pen
-        );
-        line->setData(0, "trajectory"); // 标记为轨迹
-        line->setZValue(-1); // 置于底层
+    // 小车200个点的已移动轨迹（复用线段图元，多余的隐藏）
+    for (int i = 0; i < trajectoryItems.size(); i++) {
+        QGraphicsLineItem *line = trajectoryItems.at(i);
+        if (i + 1 < trajectory.size()) {
+            line->setLine(QLineF(trajectory.at(i), trajectory.at(i + 1)));
+            line->setVisible(true);
+        } else {
+            line->setVisible(false);
+        }
     }
     
-    // 在自动模式下，绘制完整的规划路径
-    if(driveMode) {
+    // 在自动模式下，绘制完整的规划路径（路线改变时才重建）
+    if (driveMode && figurePathDirty && !figurePoints.isEmpty()) {
         QPainterPath path;
-        if(!figurePoints.isEmpty()) {
-            path.moveTo(figurePoints[0]);
-            for(int i = 1; i < figurePoints.size(); i++) {
-                path.lineTo(figurePoints[i]);
-            }
-            path.closeSubpath(); // 闭合路径
-            
-            QGraphicsPathItem *figure8Path = new QGraphicsPathItem(path);
-            // 规划路径使用淡灰色（半透明）
-            figure8Path->setPen(QPen(QColor(200, 200, 200, 150), 1)); 
-            figure8Path->setBrush(Qt::NoBrush);
-            figure8Path->setZValue(-2); // 在轨迹之下
-            scene->addItem(figure8Path);
-            figure8Path->setData(0, "figure8_path");
+        path.moveTo(figurePoints.at(0));
+        for (int i = 1; i < figurePoints.size(); i++) {
+            path.lineTo(figurePoints.at(i));
         }
+        path.closeSubpath(); // 闭合路径
+        figurePathItem->setPath(path);
+        figurePathDirty = false;
     }
+    figurePathItem->setVisible(driveMode && !figurePoints.isEmpty());
 }
 
 void MainWindow::updateStatusDisplay()
 {
-    QString modeText = driveMode ? "自动模式" : "手动模式";
-    
-    // 显示状态信息
-    QString status = QString("模式: %6\n位置: (%1, %2)\n"
-                             "方向: %3°\n"
-                             "速度: %4 像素/帧\n"
-                             "轨迹点: %5")
-                    .arg(carPosition.x(), 0, 'f', 1)
-                    .arg(carPosition.y(), 0, 'f', 1)
-                    .arg(carDirection, 0, 'f', 1)
-                    .arg(carSpeed, 0, 'f', 1)
-                    .arg(trajectory.size())
-                    .arg(modeText);
+    // 显示状态信息（写入预分配的缓冲区）
+    {
+        AllocFreeScope scope("updateStatusDisplay", isSteadyState());
+        statusText.begin()
+            .append(QStringLiteral("模式: ")).append(driveMode ? QStringLiteral("自动模式") : QStringLiteral("手动模式"))
+            .append(QStringLiteral("\n位置: (")).appendNumber(carPosition.x(), 1)
+            .append(QLatin1String(", ")).appendNumber(carPosition.y(), 1)
+            .append(QStringLiteral(")\n方向: ")).appendNumber(carDirection, 1)
+            .append(QStringLiteral("°\n速度: ")).appendNumber(carSpeed, 1)
+            .append(QStringLiteral(" 像素/帧\n轨迹点: ")).appendNumber(int(trajectory.size()));
+    }
     
-    ui->statusLabel->setText(status);
+    ui->statusLabel->setText(statusText.text());
+}
+
+QRectF MainWindow::visibleSceneRect() const
+{
+    // 视图没有缩放和旋转，只映射左上角和右下角（不生成QPolygonF）
+    QRect rect = ui->graphicsView->viewport()->rect();
+    return QRectF(ui->graphicsView->mapToScene(rect.topLeft()),
+                  ui->graphicsView->mapToScene(rect.bottomRight() + QPoint(1, 1)));
 }
 
 void MainWindow::updateCornerCoordinates()
 {
     // 获取当前视图范围
-    QRectF viewRect = ui->graphicsView->mapToScene(
-        ui->graphicsView->viewport()->rect()
-    ).boundingRect();
+    QRectF viewRect = visibleSceneRect();
     
     // 获取视图的四个角点
     QPointF topLeft = viewRect.topLeft();
@@ -465,11 +646,20 @@ void MainWindow::updateCornerCoordinates()
     QPointF bottomLeft = viewRect.bottomLeft();
     QPointF bottomRight = viewRect.bottomRight();
     
-    // 设置标签内容（格式化为整数）
-    cornerLabels[0]->setText(QString("(%1, %2)").arg(topLeft.x(), 0, 'f', 0).arg(topLeft.y(), 0, 'f', 0));
-    cornerLabels[1]->setText(QString("(%1, %2)").arg(topRight.x(), 0, 'f', 0).arg(topRight.y(), 0, 'f', 0));
-    cornerLabels[2]->setText(QString("(%1, %2)").arg(bottomLeft.x(), 0, 'f', 0).arg(bottomLeft.y(), 0, 'f', 0));
-    cornerLabels[3]->setText(QString("(%1, %2)").arg(bottomRight.x(), 0, 'f', 0).arg(bottomRight.y(), 0, 'f', 0));
+    // 设置标签内容（格式化为整数，写入预分配的缓冲区）
+    const QPointF corners[4] = { topLeft, topRight, bottomLeft, bottomRight };
+    {
+        AllocFreeScope scope("updateCornerCoordinates", isSteadyState());
+        for (int i = 0; i < 4; i++) {
+            cornerText[i].begin()
+                .append(QLatin1String("(")).appendNumber(corners[i].x(), 0)
+                .append(QLatin1String(", ")).appendNumber(corners[i].y(), 0)
+                .append(QLatin1String(")"));
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        cornerLabels[i]->setText(cornerText[i].text());
+    }
     
     // 设置标签位置（考虑到标签宽度，进行偏移）
     const int padding = 5;
@@ -493,9 +683,7 @@ void MainWindow::updateCornerCoordinates()
 void MainWindow::updateViewBorder()
 {
     // 获取当前视图范围
-    QRectF viewRect = ui->graphicsView->mapToScene(
-        ui->graphicsView->viewport()->rect()
-    ).boundingRect();
+    QRectF viewRect = visibleSceneRect();
     
     // 更新视图边框
     viewBorder->setRect(viewRect);
@@ -525,89 +713,104 @@ void MainWindow::loadImage()
         return;
     }
     
-    // 处理图像并提取曲线点
-    extractCurvePoints(image);
-    
-    // 在场景中显示结果
-    // scene->clear();
-    displayPoints();
-    adjustFigure();
+    // 处理图像，一次提取所有笔画
+    QVector<QVector<QPointF>> strokes = RouteLibrary::extractCurvePoints(image, RouteLibrary::MIN_STROKE_AREA);
+    if (strokes.isEmpty()) {
+        QMessageBox::warning(this, "Warning", "未识别到路线！");
+        return;
+    }
+
+    // 存入路线库，按长度从长到短排序
+    routeLibrary.clear();
+    for (const QVector<QPointF> &stroke : strokes) {
+        routeLibrary.addRoute(stroke);
+    }
+    routeLibrary.sortByLength();
+
+    // 更新路线选择框
+    ui->routeCombo->blockSignals(true);
+    ui->routeCombo->clear();
+    for (int i = 0; i < routeLibrary.size(); i++) {
+        const RouteInfo &info = routeLibrary.route(i);
+        ui->routeCombo->addItem(QString("路线%1 (长度%2)").arg(i + 1).arg(info.length, 0, 'f', 0));
+        ui->routeCombo->setItemData(i, QString("点数: %1\n平均曲率: %2\n最大曲率: %3")
+                                        .arg(info.points.size())
+                                        .arg(info.meanCurvature, 0, 'f', 4)
+                                        .arg(info.maxCurvature, 0, 'f', 4),
+                                    Qt::ToolTipRole);
+    }
+    if (routeLibrary.size() > 1) {
+        ui->routeCombo->addItem("串联全部路线");
+    }
+    ui->routeCombo->setCurrentIndex(0);
+    ui->routeCombo->blockSignals(false);
+
+    // 默认选择最长的路线
+    onRouteSelected(0);
 }
 
-void MainWindow::extractCurvePoints(cv::Mat image) 
+void MainWindow::onRouteSelected(int index)
 {
-    figurePoints.clear();
+    if (index < 0 || routeLibrary.isEmpty()) return;
 
-    // 1. 二值化图像
-    cv::Mat binary;
-    cv::threshold(image, binary, 128, 255, cv::THRESH_BINARY_INV);
+    // 选择框选择会取消Ctrl+点击的自定义串联
+    chainOrder.clear();
+    ui->statusbar->clearMessage();
 
-    // 2. 提取图像骨架（中心线）
-    cv::Mat skeleton = cv::Mat::zeros(binary.size(), CV_8UC1);
-    cv::Mat temp;
-    cv::Mat eroded;
+    QVector<int> order;
+    if (index < routeLibrary.size()) {
+        order.append(index);
+    } else {
+        // 按路线库顺序串联所有路线
+        for (int i = 0; i < routeLibrary.size(); i++) order.append(i);
+    }
+    selectRoutes(order);
+}
 
-    cv::Mat element = cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3, 3));
+void MainWindow::toggleChainRoute(int index)
+{
+    if (chainOrder.isEmpty()) {
+        // 以选择框中当前的单条路线作为串联的第一条
+        int current = ui->routeCombo->currentIndex();
+        if (current >= 0 && current < routeLibrary.size() && current != index) chainOrder.append(current);
+    }
 
-    bool done;
-    do {
-        cv::erode(binary, eroded, element);
-        cv::dilate(eroded, temp, element);
-        cv::subtract(binary, temp, temp);
-        cv::bitwise_or(skeleton, temp, skeleton);
-        eroded.copyTo(binary);
-        
-        done = (cv::countNonZero(binary) == 0);
-    } while (!done);
-
-    // 3. 查找骨架轮廓
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(skeleton, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
-
-    // 4. 找到最长的轮廓
-    int maxIndex = -1;
-    double maxLength = 0;
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        double length = cv::arcLength(contours[i], false);
-        if (length > maxLength) {
-            maxLength = length;
-            maxIndex = i;
-        }
+    // 已在串联中则移除，否则追加到末尾
+    if (!chainOrder.removeOne(index)) chainOrder.append(index);
+
+    if (chainOrder.isEmpty()) {
+        onRouteSelected(ui->routeCombo->currentIndex());
+        return;
     }
 
-    // 5. 对轮廓点进行平滑处理
-    if (maxIndex >= 0) {
-        std::vector<cv::Point> smoothedContour;
-        
-        // 使用高斯滤波平滑轮廓
-        std::vector<cv::Point2f> contourFloat;
-        for (const auto& pt : contours[maxIndex]) {
-            contourFloat.emplace_back(pt.x, pt.y);
-        }
-        
-        // 应用高斯平滑
-        cv::Mat contourMat(contourFloat);
-        cv::GaussianBlur(contourMat, contourMat, cv::Size(5, 5), 1.5);
-        
-        // 转换为整数点
-        for (int i = 0; i < contourMat.rows; i++) {
-            cv::Point2f pt = contourMat.at<cv::Point2f>(i);
-            smoothedContour.emplace_back(cvRound(pt.x), cvRound(pt.y));
-        }
-        
-        // 6. 采样点以减少点数并保持平滑
-        const int sampleStep = 5; // 每5个点采样一个
-        for (int i = 0; i < smoothedContour.size(); i += sampleStep) {
-            figurePoints.append(QPointF(smoothedContour[i].x, smoothedContour[i].y));
-        }
+    QString message = "串联顺序:";
+    for (int i = 0; i < chainOrder.size(); i++) {
+        message += QString(i == 0 ? " %1" : " → %1").arg(chainOrder[i] + 1);
+    }
+    ui->statusbar->showMessage(message);
+    selectRoutes(chainOrder);
+}
+
+void MainWindow::selectRoutes(const QVector<int> &order)
+{
+    if (order.size() == 1) {
+        figurePoints = routeLibrary.route(order.first()).points;
+    } else {
+        figurePoints = routeLibrary.chain(order);
     }
+
+    // 在场景中显示结果
+    displayRouteLibrary(order);
+    adjustFigure();
+
+    // 新路线从头开始（与按下手写按钮一致），避免索引超出较短路线的范围
+    figureIndex = 0;
 }
 
 void MainWindow::displayPoints() {
     if (figurePoints.isEmpty()) return;
 
-    scene_2->clear();
+    libraryShown = false;
     
     // 绘制曲线
     QPainterPath path;
@@ -617,12 +820,85 @@ void MainWindow::displayPoints() {
         path.lineTo(figurePoints[i]);
     }
     
-    auto pathItem = new QGraphicsPathItem(path);
+    // 复用图元池中的第一个图元，其余隐藏
+    QGraphicsPathItem *pathItem = routeItem_2(0);
+    pathItem->setPath(path);
     pathItem->setPen(QPen(Qt::red, 1));
-    scene_2->addItem(pathItem);
+    pathItem->setZValue(1);
+    hideRouteItems_2(1);
 
     // 自适应视图范围（带边距）
     QRectF pathRect = path.boundingRect().adjusted(-20, -20, 20, 20); // 增加20px边距
     scene_2->setSceneRect(pathRect);
     ui->graphicsView_2->fitInView(pathRect, Qt::KeepAspectRatio);
-}
\ No newline at end of file
+}
+
+void MainWindow::displayRouteLibrary(const QVector<int> &selected)
+{
+    libraryShown = true;
+
+    // 所有路线用浅灰色显示，选中（参与串联）的路线用红色
+    for (int i = 0; i < routeLibrary.size(); i++) {
+        const QVector<QPointF> &points = routeLibrary.route(i).points;
+        QPainterPath path;
+        path.moveTo(points.first());
+        for (int j = 1; j < points.size(); j++) {
+            path.lineTo(points[j]);
+        }
+
+        QGraphicsPathItem *pathItem = routeItem_2(i);
+        pathItem->setPath(path);
+        bool highlight = selected.contains(i);
+        pathItem->setPen(QPen(highlight ? Qt::red : Qt::lightGray, 1));
+        pathItem->setZValue(highlight ? 1 : 0);
+    }
+    hideRouteItems_2(routeLibrary.size());
+
+    // 自适应视图范围（带边距）
+    QRectF libraryRect = routeLibrary.bounds().adjusted(-20, -20, 20, 20); // 增加20px边距
+    scene_2->setSceneRect(libraryRect);
+    ui->graphicsView_2->fitInView(libraryRect, Qt::KeepAspectRatio);
+}
+
+QGraphicsPathItem *MainWindow::routeItem_2(int index)
+{
+    // 图元不足时才创建，之后一直复用
+    while (routeItems_2.size() <= index) {
+        auto pathItem = new QGraphicsPathItem();
+        scene_2->addItem(pathItem);
+        routeItems_2.append(pathItem);
+    }
+    routeItems_2[index]->setVisible(true);
+    return routeItems_2[index];
+}
+
+void MainWindow::hideRouteItems_2(int from)
+{
+    for (int i = from; i < routeItems_2.size(); i++) {
+        routeItems_2[i]->setVisible(false);
+    }
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    // 在显示框B中点击选择路线，Ctrl+点击按点击顺序串联多条路线
+    if (watched == ui->graphicsView_2->viewport() && event->type() == QEvent::MouseButtonPress
+            && libraryShown) {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        QPointF scenePos = ui->graphicsView_2->mapToScene(mouseEvent->position().toPoint());
+        double tolerance = 8.0 / ui->graphicsView_2->transform().m11(); // 8个屏幕像素
+        int index = routeLibrary.routeAt(scenePos, tolerance);
+        if (index >= 0) {
+            if (mouseEvent->modifiers() & Qt::ControlModifier) {
+                toggleChainRoute(index);
+            } else if (index == ui->routeCombo->currentIndex()) {
+                onRouteSelected(index); // 选择框不会再发出信号，直接取消串联
+            } else {
+                ui->routeCombo->setCurrentIndex(index);
+            }
+        }
+        return true;
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
@@ -10,6 +10,11 @@
 #include <QGraphicsPolygonItem>
 #include <QGraphicsPathItem>
 #include "global.h"
+#include "carview.h"
+#include "telemetry.h"
+#include "routelibrary.h"
+#include "simulator.h"
+#include "frametext.h"
 #include <QFileDialog>
 #include <QDebug>
 #include <QMessageBox>
@@ -27,8 +32,18 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // 对比QGraphicsView和自绘视图的渲染耗时（结果输出到qDebug）
+    void benchmarkRenderers(int frames);
+
+    // 小车视图（场景视图和自绘视图）是否抗锯齿，纯CPU渲染时关闭可明显降低每帧开销
+    void setAntialiasing(bool enabled);
+
+    // 开始监听遥测套接字（渲染测试模式下不启动）
+    void startTelemetry();
+
 protected:
     void resizeEvent(QResizeEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
     
 private slots:
     // 控制按钮槽函数
@@ -47,7 +62,12 @@ private slots:
     void releaseControls();
 
     void loadImage();
+    void onRouteSelected(int index); // 选择路线（最后一项为串联全部）
     void onInitPressed();
+    void onRendererPressed(); // 切换渲染方式
+
+    // 外部控制器发来的控制命令
+    void onTelemetryCommand(quint16 code);
 
 private:
     Ui::MainWindow *ui;
@@ -58,10 +78,12 @@ private:
     QGraphicsRectItem *carBody;     // 小车车身
     QGraphicsPolygonItem *carHead; // 车头指示器
     QVector<QPointF> trajectory;
+    const int TRAJECTORY_LIMIT = 200; // 轨迹点数上限
     const double CAR_LENGTH = 60.0; // 小车长度（像素）
     const double CAR_WIDTH = 30.0;  // 小车宽度
     
     // 运动参数
+    ControllerParams params = defaultControllerParams(); // 转向/加减速步长、最大速度等
     double carSpeed = 0;   // 像素/帧
     double carDirection = 0; // 角度（初始0°）
     QPointF carPosition;  // 中心点坐标
@@ -75,28 +97,85 @@ private:
     
     // 轨迹参数
     QVector<QPointF> figurePoints;
-    int figureIndex = 0; // 当前8字形点索引
+    int figureIndex = 0; // 自动模式下当前最近路线点索引
+    bool routeAborted = false; // 本帧因偏离路线太远退出自动模式
+    const int ABORT_MESSAGE_MS = 5000; // 偏离路线提示在状态栏显示的时间
     double figure8Size = 300; // 8字形大小
+
+    // 手写路线库（一张图片中识别到的所有笔画）
+    RouteLibrary routeLibrary;
+    bool libraryShown = false; // 显示框B当前是否显示路线库
+    QVector<int> chainOrder; // Ctrl+点击选择的串联顺序（为空时使用选择框）
     
     // 定时器
     QTimer *timer;
     
     // 坐标标注
     QGraphicsSimpleTextItem *cornerLabels[4]; // 四个角的坐标标签
+
+    // 场景图元池（启动时创建，之后只更新不重建）
+    QVector<QGraphicsLineItem*> trajectoryItems; // 轨迹线段
+    QColor trajectoryColor;                      // 轨迹线段当前颜色
+    QGraphicsPathItem *figurePathItem;           // 规划路径
+    bool figurePathDirty = true;                 // 规划路径已改变，需要重建
+    QVector<QGraphicsPathItem*> routeItems_2;    // 显示框B中的路线
+
+    // 预分配的文本缓冲（稳态帧不产生堆分配）
+    FrameText statusText{256};
+    FrameText cornerText[4];
+
+    // 预热帧数：之后的帧在调试版本中检查零分配
+    const quint64 WARMUP_TICKS = 30;
+    const quint64 ALLOC_LOG_INTERVAL = 300; // 调试版本输出整帧堆分配次数的间隔（帧）
+    bool isSteadyState() const { return tickCount > WARMUP_TICKS; }
     
     // 视图边框
     QGraphicsRectItem *viewBorder, *viewBorder_2;
+
+    // 自绘视图（替代graphicsView，不经过QGraphicsScene）
+    CarView *carView;
+    bool antialiasing = true;
+    bool useCarView = false;
+
+    // 遥测服务（推送小车状态，接收外部控制命令）
+    TelemetryServer *telemetry;
+    quint64 tickCount = 0;
     
+    // 运动计算（按驾驶模式更新位置、方向和速度）
+    void stepMotion();
+
+    // 记录轨迹点（轨迹满后覆盖最旧的点）
+    void recordTrajectory();
+
     // 更新状态显示
     void updateStatusDisplay();
+
+    // 推送当前帧遥测数据
+    void publishTelemetry();
     
     // 绘制轨迹
     void drawTrajectory();
+
+    // 创建轨迹和规划路径的图元池
+    void createScenePools();
+
+    // 取显示框B路线图元池中的第index个图元（不足时创建）
+    QGraphicsPathItem *routeItem_2(int index);
+    void hideRouteItems_2(int from);
+
+    // 当前视图对应的场景范围
+    QRectF visibleSceneRect() const;
     
     // 更新角落坐标标签
     void updateCornerCoordinates();
 
     void updateSceneRect();
+
+    // 同步场景中的小车、视图中心、坐标标签和边框
+    void updateSceneView();
+
+    // 切换场景视图/自绘视图
+    void setCarViewEnabled(bool enabled);
     
     // 确保视图中心跟随小车
     void centerViewOnCar();
@@ -110,8 +189,12 @@ private:
     // 更新视图边框
     void updateViewBorder();
 
-    void extractCurvePoints(cv::Mat image);
     void displayPoints();
+    void displayRouteLibrary(const QVector<int> &selected);
+
+    // 将路线（多条时按顺序串联）设为当前路线
+    void selectRoutes(const QVector<int> &order);
+    void toggleChainRoute(int index);
     void adjustFigure();
 };
 #endif // MAINWINDOW_H
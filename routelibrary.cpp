@@ -0,0 +1,320 @@
+#include "routelibrary.h"
+#include <QPolygonF>
+#include <QLineF>
+#include <QSet>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+void RouteLibrary::clear()
+{
+    routes.clear();
+    grid.clear();
+    totalBounds = QRectF();
+}
+
+quint64 RouteLibrary::cellKey(int cx, int cy) const
+{
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+int RouteLibrary::addRoute(const QVector<QPointF> &points)
+{
+    RouteInfo info;
+    info.points = points;
+    info.bounds = QPolygonF(points).boundingRect();
+    info.length = 0;
+    info.meanCurvature = 0;
+    info.maxCurvature = 0;
+
+    // 长度
+    for (int i = 1; i < points.size(); i++) {
+        info.length += QLineF(points[i-1], points[i]).length();
+    }
+
+    // 曲率：相邻两段的转角 / 平均段长
+    int count = 0;
+    for (int i = 1; i + 1 < points.size(); i++) {
+        QPointF d1 = points[i] - points[i-1];
+        QPointF d2 = points[i+1] - points[i];
+        double ds = (std::hypot(d1.x(), d1.y()) + std::hypot(d2.x(), d2.y())) / 2;
+        if (ds <= 0) continue;
+
+        double turn = std::atan2(d2.y(), d2.x()) - std::atan2(d1.y(), d1.x());
+        turn = std::fabs(std::remainder(turn, 2.0 * M_PI)); // 归一化到[0, π]
+        double k = turn / ds;
+        info.meanCurvature += k;
+        if (k > info.maxCurvature) info.maxCurvature = k;
+        count++;
+    }
+    if (count > 0) info.meanCurvature /= count;
+
+    int index = routes.size();
+    routes.append(info);
+    totalBounds = totalBounds.isNull() ? info.bounds : totalBounds.united(info.bounds);
+    registerRoute(index);
+    return index;
+}
+
+void RouteLibrary::registerRoute(int index)
+{
+    // 登记到包围盒覆盖的所有格子
+    const QRectF &bounds = routes[index].bounds;
+    int x0 = std::floor(bounds.left() / CELL_SIZE);
+    int x1 = std::floor(bounds.right() / CELL_SIZE);
+    int y0 = std::floor(bounds.top() / CELL_SIZE);
+    int y1 = std::floor(bounds.bottom() / CELL_SIZE);
+    for (int cx = x0; cx <= x1; cx++) {
+        for (int cy = y0; cy <= y1; cy++) {
+            grid[cellKey(cx, cy)].append(index);
+        }
+    }
+}
+
+void RouteLibrary::sortByLength()
+{
+    // 使用addRoute中已算好的长度，路线编号改变后重建网格索引
+    std::stable_sort(routes.begin(), routes.end(), [](const RouteInfo &a, const RouteInfo &b) {
+        return a.length > b.length;
+    });
+    grid.clear();
+    for (int i = 0; i < routes.size(); i++) {
+        registerRoute(i);
+    }
+}
+
+QVector<int> RouteLibrary::queryRect(const QRectF &rect) const
+{
+    QVector<int> result;
+    QSet<int> seen;
+
+    int x0 = std::floor(rect.left() / CELL_SIZE);
+    int x1 = std::floor(rect.right() / CELL_SIZE);
+    int y0 = std::floor(rect.top() / CELL_SIZE);
+    int y1 = std::floor(rect.bottom() / CELL_SIZE);
+    for (int cx = x0; cx <= x1; cx++) {
+        for (int cy = y0; cy <= y1; cy++) {
+            auto it = grid.constFind(cellKey(cx, cy));
+            if (it == grid.constEnd()) continue;
+            for (int index : it.value()) {
+                if (seen.contains(index)) continue;
+                seen.insert(index);
+                if (routes[index].bounds.intersects(rect)) result.append(index);
+            }
+        }
+    }
+    return result;
+}
+
+int RouteLibrary::routeAt(const QPointF &pos, double tolerance) const
+{
+    QRectF area(pos.x() - tolerance, pos.y() - tolerance, 2 * tolerance, 2 * tolerance);
+    int best = -1;
+    double bestDist = tolerance;
+
+    for (int index : queryRect(area)) {
+        const QVector<QPointF> &pts = routes[index].points;
+        for (int i = 1; i < pts.size(); i++) {
+            // 点到线段的距离
+            QPointF seg = pts[i] - pts[i-1];
+            double len2 = QPointF::dotProduct(seg, seg);
+            double t = len2 > 0 ? QPointF::dotProduct(pos - pts[i-1], seg) / len2 : 0;
+            t = qBound(0.0, t, 1.0);
+            double dist = QLineF(pos, pts[i-1] + t * seg).length();
+            if (dist <= bestDist) {
+                bestDist = dist;
+                best = index;
+            }
+        }
+    }
+    return best;
+}
+
+QVector<QPointF> RouteLibrary::chain(const QVector<int> &indices) const
+{
+    QVector<QPointF> result;
+    for (int index : indices) {
+        const QVector<QPointF> &pts = routes[index].points;
+        if (pts.isEmpty()) continue;
+
+        // 选择离上一条路线终点较近的一端作为起点
+        bool reversed = false;
+        if (!result.isEmpty()) {
+            double toFirst = QLineF(result.last(), pts.first()).length();
+            double toLast = QLineF(result.last(), pts.last()).length();
+            reversed = toLast < toFirst;
+        }
+
+        // 与上一条路线之间的空隙按CHAIN_STEP插值，保证路线点连续（小车按最近点跟踪路线）
+        if (!result.isEmpty()) {
+            QPointF from = result.last();
+            QPointF to = reversed ? pts.last() : pts.first();
+            int steps = int(QLineF(from, to).length() / CHAIN_STEP);
+            for (int i = 1; i < steps; i++) {
+                result.append(from + (to - from) * (double(i) / steps));
+            }
+        }
+
+        result.reserve(result.size() + pts.size());
+        if (reversed) {
+            for (int i = pts.size() - 1; i >= 0; i--) result.append(pts[i]);
+        } else {
+            result.append(pts);
+        }
+    }
+    return result;
+}
+
+// 骨架轮廓（RETR_EXTERNAL）沿笔画走一个来回，在笔画末端原路折返180°
+// 找出折返点（末端），只保留两个末端之间的单程路径；没有末端（闭合笔画）时保留整个轮廓
+static std::vector<cv::Point> strokePath(const std::vector<cv::Point> &contour)
+{
+    int n = contour.size();
+    if (n < 5) return contour;
+
+    auto adjacent = [](const cv::Point &a, const cv::Point &b) {
+        cv::Point d = a - b;
+        return d.x * d.x + d.y * d.y <= 2; // 同一像素或8邻域
+    };
+
+    // 折返点：前后各两个轮廓点重合（或相邻，骨架末端有两像素宽时）
+    std::vector<int> tips;
+    for (int k = 0; k < n; k++) {
+        if (adjacent(contour[(k + n - 1) % n], contour[(k + 1) % n])
+                && adjacent(contour[(k + n - 2) % n], contour[(k + 2) % n])) {
+            // 同一末端的相邻候选只保留第一个
+            if (!tips.empty() && k - tips.back() <= 2) continue;
+            tips.push_back(k);
+        }
+    }
+    if (tips.size() >= 2 && tips.front() + n - tips.back() <= 2) tips.pop_back(); // 首尾跨越下标0的同一末端
+    if (tips.size() < 2) return contour;
+
+    // 选择两个方向的轮廓距离都最长的一对末端（主笔画两端），短分叉的末端不会被选中
+    int bestA = tips[0], bestB = tips[1], bestSpan = -1;
+    for (size_t i = 0; i < tips.size(); i++) {
+        for (size_t j = i + 1; j < tips.size(); j++) {
+            int forward = tips[j] - tips[i];
+            int span = qMin(forward, n - forward);
+            if (span > bestSpan) {
+                bestSpan = span;
+                bestA = tips[i];
+                bestB = tips[j];
+            }
+        }
+    }
+
+    // 两个方向都是同一笔画，取点数较少的一侧（经过的分叉较少）
+    int forward = bestB - bestA;
+    int from = forward <= n - forward ? bestA : bestB;
+    int count = qMin(forward, n - forward) + 1;
+    std::vector<cv::Point> path;
+    path.reserve(count);
+    for (int i = 0; i < count; i++) path.push_back(contour[(from + i) % n]);
+    return path;
+}
+
+// 对单个连通域（二值图）提取骨架中心线，offset为其在原图中的位置
+static QVector<QPointF> extractStroke(cv::Mat mask, cv::Point offset)
+{
+    QVector<QPointF> points;
+
+    // 四周补一圈背景，避免腐蚀时边界被当作前景
+    cv::Mat binary;
+    cv::copyMakeBorder(mask, binary, 1, 1, 1, 1, cv::BORDER_CONSTANT, 0);
+    offset -= cv::Point(1, 1);
+
+    // 1. 提取图像骨架（中心线）
+    cv::Mat skeleton = cv::Mat::zeros(binary.size(), CV_8UC1);
+    cv::Mat temp;
+    cv::Mat eroded;
+
+    cv::Mat element = cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3, 3));
+
+    bool done;
+    do {
+        cv::erode(binary, eroded, element);
+        cv::dilate(eroded, temp, element);
+        cv::subtract(binary, temp, temp);
+        cv::bitwise_or(skeleton, temp, skeleton);
+        eroded.copyTo(binary);
+        
+        done = (cv::countNonZero(binary) == 0);
+    } while (!done);
+
+    // 2. 查找骨架轮廓
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(skeleton, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE, offset);
+
+    // 3. 找到最长的轮廓
+    int maxIndex = -1;
+    double maxLength = 0;
+
+    for (size_t i = 0; i < contours.size(); i++) {
+        double length = cv::arcLength(contours[i], false);
+        if (length > maxLength) {
+            maxLength = length;
+            maxIndex = i;
+        }
+    }
+
+    // 4. 对轮廓点进行平滑处理
+    if (maxIndex >= 0) {
+        std::vector<cv::Point> smoothedContour;
+        
+        // 使用高斯滤波平滑轮廓（只取末端之间的单程路径）
+        std::vector<cv::Point2f> contourFloat;
+        for (const auto& pt : strokePath(contours[maxIndex])) {
+            contourFloat.emplace_back(pt.x, pt.y);
+        }
+        
+        // 应用高斯平滑
+        cv::Mat contourMat(contourFloat);
+        cv::GaussianBlur(contourMat, contourMat, cv::Size(5, 5), 1.5);
+        
+        // 转换为整数点
+        for (int i = 0; i < contourMat.rows; i++) {
+            cv::Point2f pt = contourMat.at<cv::Point2f>(i);
+            smoothedContour.emplace_back(cvRound(pt.x), cvRound(pt.y));
+        }
+        
+        // 5. 采样点以减少点数并保持平滑
+        const int sampleStep = 5; // 每5个点采样一个
+        for (int i = 0; i < smoothedContour.size(); i += sampleStep) {
+            points.append(QPointF(smoothedContour[i].x, smoothedContour[i].y));
+        }
+    }
+    return points;
+}
+
+QVector<QVector<QPointF>> RouteLibrary::extractCurvePoints(cv::Mat image, int minArea)
+{
+    // 1. 二值化图像
+    cv::Mat binary;
+    cv::threshold(image, binary, 128, 255, cv::THRESH_BINARY_INV);
+
+    // 2. 连通域分割，每个连通域为一笔（标签0为背景）
+    cv::Mat labels, stats, centroids;
+    int count = cv::connectedComponentsWithStats(binary, labels, stats, centroids, 8, CV_32S);
+
+    // 3. 各连通域并行提取中心线
+    std::vector<QVector<QPointF>> results(count);
+    cv::parallel_for_(cv::Range(1, count), [&](const cv::Range &range) {
+        for (int label = range.start; label < range.end; label++) {
+            if (stats.at<int>(label, cv::CC_STAT_AREA) < minArea) continue; // 忽略噪点
+            cv::Rect box(stats.at<int>(label, cv::CC_STAT_LEFT),
+                         stats.at<int>(label, cv::CC_STAT_TOP),
+                         stats.at<int>(label, cv::CC_STAT_WIDTH),
+                         stats.at<int>(label, cv::CC_STAT_HEIGHT));
+            cv::Mat mask = (labels(box) == label);
+            results[label] = extractStroke(mask, box.tl());
+        }
+    });
+
+    // 4. 去掉无效笔画（按连通域标签顺序返回）
+    QVector<QVector<QPointF>> strokes;
+    for (const QVector<QPointF> &points : results) {
+        if (points.size() >= 2) strokes.append(points);
+    }
+    return strokes;
+}
@@ -0,0 +1,68 @@
+#ifndef ROUTELIBRARY_H
+#define ROUTELIBRARY_H
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QHash>
+#include <opencv2/opencv.hpp>
+
+// 单条路线及其统计信息
+typedef struct
+{
+    QVector<QPointF> points;
+    QRectF bounds;          // 包围盒
+    double length;          // 路线长度（像素）
+    double meanCurvature;   // 平均曲率（弧度/像素）
+    double maxCurvature;    // 最大曲率
+} RouteInfo;
+
+// 内存路线库：保存图片中识别到的所有路线，按包围盒建立网格空间索引
+class RouteLibrary
+{
+public:
+    // 从图片中提取所有笔画（每个连通域一条），按连通域标签顺序返回
+    // minArea：小于该像素数的连通域视为噪点
+    static QVector<QVector<QPointF>> extractCurvePoints(cv::Mat image, int minArea);
+
+    // 界面和调参程序共用的噪点面积阈值（像素数）
+    static constexpr int MIN_STROKE_AREA = 20;
+
+    void clear();
+
+    // 添加路线并计算统计信息，返回路线编号
+    int addRoute(const QVector<QPointF> &points);
+
+    int size() const { return routes.size(); }
+    bool isEmpty() const { return routes.isEmpty(); }
+    const RouteInfo &route(int index) const { return routes[index]; }
+
+    // 按路线长度从长到短排序（路线编号随之改变）
+    void sortByLength();
+
+    // 所有路线的总包围盒
+    QRectF bounds() const { return totalBounds; }
+
+    // 包围盒与rect相交的路线编号
+    QVector<int> queryRect(const QRectF &rect) const;
+
+    // 距离pos最近（且不超过tolerance）的路线编号，没有则返回-1
+    int routeAt(const QPointF &pos, double tolerance) const;
+
+    // 按给定顺序串联路线，每条路线自动选择与上一条终点较近的一端作为起点，路线之间的空隙用直线插值连接
+    QVector<QPointF> chain(const QVector<int> &indices) const;
+
+private:
+    quint64 cellKey(int cx, int cy) const;
+    void registerRoute(int index);
+
+    QVector<RouteInfo> routes;
+    QRectF totalBounds;
+
+    // 网格索引：格子 -> 包围盒覆盖该格子的路线编号
+    QHash<quint64, QVector<int>> grid;
+    const double CELL_SIZE = 100.0;
+    const double CHAIN_STEP = 5.0; // 串联空隙插值点间距（与笔画采样间距相近）
+};
+
+#endif // ROUTELIBRARY_H
@@ -0,0 +1,177 @@
+#include "simulator.h"
+#include <QLineF>
+#include <QtMath>
+#include <cmath>
+
+ControllerParams defaultControllerParams()
+{
+    ControllerParams params;
+    params.turnStep = 2.0;
+    params.accelStep = 0.2;
+    params.maxSpeed = 10;
+    params.targetSpeed = 5;
+    params.lookahead = 20;
+    return params;
+}
+
+double controllerParam(const ControllerParams &params, int index)
+{
+    switch (index)
+    {
+    case 0: return params.turnStep;
+    case 1: return params.accelStep;
+    case 2: return params.maxSpeed;
+    case 3: return params.targetSpeed;
+    default: return params.lookahead;
+    }
+}
+
+void setControllerParam(ControllerParams &params, int index, double value)
+{
+    switch (index)
+    {
+    case 0: params.turnStep = value; break;
+    case 1: params.accelStep = value; break;
+    case 2: params.maxSpeed = value; break;
+    case 3: params.targetSpeed = value; break;
+    default: params.lookahead = value; break;
+    }
+}
+
+const char *controllerParamName(int index)
+{
+    static const char *names[CONTROLLER_PARAM_COUNT] = {
+        "turnStep", "accelStep", "maxSpeed", "targetSpeed", "lookahead"
+    };
+    return names[qBound(0, index, CONTROLLER_PARAM_COUNT - 1)];
+}
+
+QVector<QPointF> Simulator::figure8Points(double size, int totalPoints)
+{
+    QVector<QPointF> points;
+    points.reserve(totalPoints);
+
+    // 标准8字形参数方程（以原点为中心）
+    for(int i = 0; i < totalPoints; i++) {
+        double t = 2.0 * M_PI * i / totalPoints;
+        double x = size * sin(t) / (1 + pow(cos(t), 2));
+        double y = size * sin(t) * cos(t) / (1 + pow(cos(t), 2));
+        points.append(QPointF(x, y));
+    }
+    return points;
+}
+
+double Simulator::updateNearest(VehicleState &state, const QVector<QPointF> &route)
+{
+    int n = route.size();
+    state.index = qBound(0, state.index, n - 1);
+    double error = QLineF(state.position, route[state.index]).length();
+    int last = qMin(state.index + SEARCH_WINDOW, n - 1);
+    for (int j = state.index + 1; j <= last; j++) {
+        double d = QLineF(state.position, route[j]).length();
+        if (d < error) {
+            error = d;
+            state.index = j;
+        }
+    }
+    return error;
+}
+
+void Simulator::controlStep(VehicleState &state, const QVector<QPointF> &route, const ControllerParams &params)
+{
+    int n = route.size();
+
+    // 1. 预瞄点
+    int target = state.index;
+    double ahead = 0;
+    while (target < n - 1 && ahead < params.lookahead) {
+        ahead += QLineF(route[target], route[target + 1]).length();
+        target++;
+    }
+
+    // 2. 转向（每帧最多转turnStep度）
+    double desired = qRadiansToDegrees(std::atan2(route[target].y() - state.position.y(),
+                                                  route[target].x() - state.position.x()));
+    double diff = std::remainder(desired - state.direction, 360.0);
+    state.direction += qBound(-params.turnStep, diff, params.turnStep);
+
+    // 3. 加减速（每帧最多变化accelStep）
+    double targetSpeed = qMin(params.targetSpeed, params.maxSpeed);
+    state.speed += qBound(-params.accelStep, targetSpeed - state.speed, params.accelStep);
+    state.speed = qBound(0.0, state.speed, params.maxSpeed);
+
+    move(state);
+}
+
+void Simulator::move(VehicleState &state)
+{
+    // 计算位移增量（极坐标转换）
+    double rad = qDegreesToRadians(state.direction);
+    state.position += QPointF(state.speed * cos(rad), state.speed * sin(rad));
+}
+
+EvalResult Simulator::evaluate(const QVector<QPointF> &route, const ControllerParams &params,
+                               double costBound)
+{
+    EvalResult result;
+    result.cost = FAIL_COST;
+    result.meanError = 0;
+    result.maxError = 0;
+    result.frames = 0;
+    result.finished = false;
+    result.pruned = false;
+
+    int n = route.size();
+    if (n < 2) return result;
+
+    // 最多帧数：平均速度低于0.5像素/帧视为失败
+    double routeLength = 0;
+    for (int i = 1; i < n; i++) {
+        routeLength += QLineF(route[i-1], route[i]).length();
+    }
+    int maxFrames = int(routeLength / 0.5) + 100;
+
+    // 从路线起点出发，方向与路线起始方向一致
+    VehicleState state;
+    state.position = route[0];
+    state.direction = qRadiansToDegrees(std::atan2(route[1].y() - route[0].y(), route[1].x() - route[0].x()));
+    state.speed = 0;
+    state.index = 0;
+    double errorSum = 0;
+
+    for (int frame = 1; frame <= maxFrames; frame++) {
+        double error = updateNearest(state, route);
+
+        result.frames = frame;
+        if (error > ABORT_ERROR) {
+            result.cost = FAIL_COST + (n - 1 - state.index); // 偏离太远
+            return result;
+        }
+        errorSum += error;
+        if (error > result.maxError) result.maxError = error;
+
+        if (state.index >= n - 1) {
+            result.finished = true;
+            break;
+        }
+
+        // 耗时代价已超过上界，不可能更优：记录已行驶部分的代价（真实代价的下界）
+        if (TIME_WEIGHT * frame >= costBound) {
+            result.pruned = true;
+            result.meanError = errorSum / frame;
+            result.cost = result.meanError + TIME_WEIGHT * frame;
+            return result;
+        }
+
+        controlStep(state, route, params);
+    }
+
+    if (!result.finished) {
+        result.cost = FAIL_COST + (n - 1 - state.index); // 超时未走完
+        return result;
+    }
+
+    result.meanError = errorSum / result.frames;
+    result.cost = result.meanError + TIME_WEIGHT * result.frames;
+    return result;
+}
@@ -0,0 +1,78 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <QVector>
+#include <QPointF>
+
+// 小车与路径跟踪控制参数
+typedef struct
+{
+    double turnStep;     // 每帧最大转角（度）
+    double accelStep;    // 每帧速度变化量
+    double maxSpeed;     // 最大速度（像素/帧）
+    double targetSpeed;  // 自动模式目标速度
+    double lookahead;    // 预瞄距离（像素）
+} ControllerParams;
+
+#define CONTROLLER_PARAM_COUNT 5
+
+// 界面当前使用的默认参数
+ControllerParams defaultControllerParams();
+
+// 按下标读写参数（供调参程序统一处理）
+double controllerParam(const ControllerParams &params, int index);
+void setControllerParam(ControllerParams &params, int index, double value);
+const char *controllerParamName(int index);
+
+// 单次路径跟踪评估结果
+typedef struct
+{
+    double cost;        // 综合代价（越小越好）
+    double meanError;   // 平均偏离路线距离
+    double maxError;    // 最大偏离距离
+    int frames;         // 走完路线所用帧数
+    bool finished;      // 是否走完路线
+    bool pruned;        // 代价超过剪枝上界而提前终止（不是失败，cost为已行驶部分的代价下界）
+} EvalResult;
+
+// 小车运动状态
+typedef struct
+{
+    QPointF position;   // 中心点坐标
+    double direction;   // 方向（角度）
+    double speed;       // 速度（像素/帧）
+    int index;          // 当前最近路线点索引
+} VehicleState;
+
+// 路径跟踪模拟：界面的自动模式和调参程序使用同一套运动学和预瞄控制器
+class Simulator
+{
+public:
+    // 生成8字形轨迹点（以原点为中心）
+    static QVector<QPointF> figure8Points(double size, int totalPoints = 200);
+
+    // 从state.index向前搜索最近路线点并更新索引，返回偏离路线的距离
+    static double updateNearest(VehicleState &state, const QVector<QPointF> &route);
+
+    // 预瞄控制一帧：朝预瞄点转向、向目标速度加减速，然后移动
+    static void controlStep(VehicleState &state, const QVector<QPointF> &route, const ControllerParams &params);
+
+    // 按当前方向和速度移动一帧（极坐标位移，手动模式也使用）
+    static void move(VehicleState &state);
+
+    // 沿route行驶一遍并计算代价
+    // costBound：代价已不可能低于该值时提前终止
+    static EvalResult evaluate(const QVector<QPointF> &route, const ControllerParams &params,
+                               double costBound);
+
+    // 偏离路线超过该距离视为失败
+    static constexpr double ABORT_ERROR = 100.0;
+    // 代价中每帧耗时的权重
+    static constexpr double TIME_WEIGHT = 0.01;
+    // 失败时的代价基数
+    static constexpr double FAIL_COST = 1e6;
+    // 只向前搜索最近点的范围，避免在路线交叉处跳跃
+    static constexpr int SEARCH_WINDOW = 20;
+};
+
+#endif // SIMULATOR_H
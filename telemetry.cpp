@@ -0,0 +1,99 @@
+#include "telemetry.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDebug>
+#ifdef Q_OS_UNIX
+#include <sys/socket.h>
+#endif
+
+TelemetryServer::TelemetryServer(QObject *parent)
+    : QObject(parent)
+{
+    server = new QLocalServer(this);
+    connect(server, &QLocalServer::newConnection, this, &TelemetryServer::onNewConnection);
+}
+
+bool TelemetryServer::listen(const QString &name)
+{
+    // 已有实例在监听时不抢占它的套接字
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(PROBE_TIMEOUT_MS)) {
+        probe.disconnectFromServer();
+        qDebug() << "遥测服务未启动: 已有实例在使用" << name;
+        return false;
+    }
+    // 无人应答，说明是上次异常退出残留的套接字文件，清除后再监听
+    QLocalServer::removeServer(name);
+    if (!server->listen(name)) {
+        qDebug() << "遥测服务启动失败:" << server->errorString();
+        return false;
+    }
+    qDebug() << "遥测服务:" << server->fullServerName();
+    return true;
+}
+
+void TelemetryServer::publish(const TelemetryFrame &frame)
+{
+    const qint64 maxPending = qint64(MAX_PENDING_FRAMES - 1) * sizeof(TelemetryFrame);
+    // 遍历副本：写入失败时套接字会同步发出disconnected，onDisconnected会修改clients
+    const QList<QLocalSocket*> targets = clients;
+    for (QLocalSocket *client : targets) {
+        if (client->state() != QLocalSocket::ConnectedState) continue;
+        // 内核发送缓冲区已满时数据留在Qt缓冲区，超过MAX_PENDING_FRAMES帧后丢弃新帧
+        if (client->bytesToWrite() > maxPending) continue;
+        client->write(reinterpret_cast<const char *>(&frame), sizeof(TelemetryFrame));
+        client->flush();
+    }
+}
+
+void TelemetryServer::onNewConnection()
+{
+    while (QLocalSocket *client = server->nextPendingConnection()) {
+        connect(client, &QLocalSocket::readyRead, this, &TelemetryServer::onReadyRead);
+        connect(client, &QLocalSocket::disconnected, this, &TelemetryServer::onDisconnected);
+        limitSendBuffer(client);
+        clients.append(client);
+    }
+}
+
+void TelemetryServer::limitSendBuffer(QLocalSocket *client)
+{
+#ifdef Q_OS_UNIX
+    // 把内核发送缓冲区压到最小（内核会提高到下限，Linux下约4KB，只能容纳几帧），
+    // 否则默认约200KB的缓冲区可以积压上千帧，慢客户端读到的是几秒前的状态
+    int size = MAX_PENDING_FRAMES * sizeof(TelemetryFrame);
+    if (::setsockopt(int(client->socketDescriptor()), SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) != 0) {
+        qDebug() << "遥测客户端发送缓冲区设置失败";
+    }
+#else
+    Q_UNUSED(client); // Windows下为命名管道，不限制
+#endif
+}
+
+void TelemetryServer::onReadyRead()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) return;
+
+    // 一次读取所有完整的命令包
+    ControlCommand cmd;
+    while (client->bytesAvailable() >= qint64(sizeof(ControlCommand))) {
+        client->read(reinterpret_cast<char *>(&cmd), sizeof(ControlCommand));
+        if (cmd.magic != TELEMETRY_MAGIC || cmd.version != TELEMETRY_VERSION) {
+            // 协议不匹配，断开该客户端
+            qDebug() << "遥测命令格式错误，断开客户端";
+            client->disconnectFromServer();
+            return;
+        }
+        emit commandReceived(cmd.code);
+    }
+}
+
+void TelemetryServer::onDisconnected()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) return;
+    clients.removeOne(client);
+    client->deleteLater();
+}
@@ -0,0 +1,87 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QObject>
+#include <QList>
+#include <QtGlobal>
+
+class QLocalServer;
+class QLocalSocket;
+
+// 本地IPC遥测协议（固定二进制格式，本机字节序）
+// 服务端每帧向所有客户端推送TelemetryFrame，客户端发送ControlCommand控制小车
+#define TELEMETRY_MAGIC   0x46544441 // "ADTF"
+#define TELEMETRY_VERSION 1
+
+typedef enum
+{
+    cmdLeft = 0,      // 左转（按下）
+    cmdRight = 1,     // 右转（按下）
+    cmdAccel = 2,     // 加速（按下）
+    cmdDecel = 3,     // 减速（按下）
+    cmdRelease = 4,   // 松开所有控制
+    cmdBrake = 5      // 急刹
+} TelemetryCommandCode;
+
+#pragma pack(push, 1)
+typedef struct
+{
+    quint32 magic;      // TELEMETRY_MAGIC
+    quint16 version;    // TELEMETRY_VERSION
+    quint16 size;       // sizeof(TelemetryFrame)
+    quint64 tick;       // 帧序号
+    double x;           // 位置
+    double y;
+    double direction;   // 方向（角度）
+    double speed;       // 速度（像素/帧）
+    qint32 mode;        // 驾驶模式（manualMode/figure8Mode/figureHandWriteMode）
+    qint32 routeIndex;  // 当前路线点索引
+    qint32 routeSize;   // 路线点数
+} TelemetryFrame;
+
+typedef struct
+{
+    quint32 magic;      // TELEMETRY_MAGIC
+    quint16 version;    // TELEMETRY_VERSION
+    quint16 code;       // TelemetryCommandCode
+} ControlCommand;
+#pragma pack(pop)
+
+class TelemetryServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryServer(QObject *parent = nullptr);
+
+    // 在本地套接字上监听（Linux下为Unix域套接字）
+    // 同名套接字已有实例应答时返回false，不删除对方的套接字
+    bool listen(const QString &name);
+
+    // 向所有客户端推送一帧
+    void publish(const TelemetryFrame &frame);
+
+signals:
+    void commandReceived(quint16 code);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    // 限制内核中为该客户端积压的数据量
+    void limitSendBuffer(QLocalSocket *client);
+
+    QLocalServer *server;
+    QList<QLocalSocket*> clients;
+
+    // 每个客户端在Qt缓冲区中最多积压的帧数，超过时丢弃新帧（每帧单独写出，不做合批）
+    // 内核缓冲区另外由limitSendBuffer限制到最小
+    const int MAX_PENDING_FRAMES = 2;
+
+    // 探测已有实例的超时时间
+    const int PROBE_TIMEOUT_MS = 100;
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,299 @@
+#include "tuner.h"
+#include "routelibrary.h"
+#include <QtConcurrent>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// 各参数的搜索范围（顺序与controllerParam下标一致）
+static const double PARAM_MIN[CONTROLLER_PARAM_COUNT] = { 0.5, 0.05, 2.0, 1.0, 5.0 };
+static const double PARAM_MAX[CONTROLLER_PARAM_COUNT] = { 6.0, 1.0, 20.0, 15.0, 80.0 };
+
+Tuner::Tuner(const QVector<QVector<QPointF>> &routes, quint32 seed)
+    : routes(routes)
+    , bestCost(Simulator::FAIL_COST)
+    , rng(seed)
+{
+}
+
+ControllerParams Tuner::fromUnit(const double *unit) const
+{
+    ControllerParams params = defaultControllerParams();
+    for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+        double u = qBound(0.0, unit[i], 1.0);
+        setControllerParam(params, i, PARAM_MIN[i] + u * (PARAM_MAX[i] - PARAM_MIN[i]));
+    }
+    return params;
+}
+
+void Tuner::toUnit(const ControllerParams &params, double *unit) const
+{
+    for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+        double u = (controllerParam(params, i) - PARAM_MIN[i]) / (PARAM_MAX[i] - PARAM_MIN[i]);
+        unit[i] = qBound(0.0, u, 1.0);
+    }
+}
+
+EvalResult Tuner::evaluateAll(const ControllerParams &params, double costBound) const
+{
+    EvalResult total;
+    total.cost = 0;
+    total.meanError = 0;
+    total.maxError = 0;
+    total.frames = 0;
+    total.finished = true;
+    total.pruned = false;
+
+    // 上界按所有路线的代价总和计算
+    double boundSum = costBound * routes.size();
+    double costSum = 0;
+    for (const QVector<QPointF> &route : routes) {
+        EvalResult r = Simulator::evaluate(route, params, boundSum - costSum);
+        total.frames += r.frames;
+        if (r.pruned) {
+            // 超过剪枝上界：平均代价取已评估部分的下界，不再评估剩余路线
+            total.cost = (costSum + r.cost) / routes.size();
+            total.meanError = (total.meanError + r.meanError) / routes.size();
+            total.maxError = qMax(total.maxError, r.maxError);
+            total.finished = false;
+            total.pruned = true;
+            return total;
+        }
+        if (!r.finished) {
+            // 任一路线失败即终止，不再评估剩余路线
+            total.cost = r.cost;
+            total.finished = false;
+            return total;
+        }
+        costSum += r.cost;
+        total.meanError += r.meanError;
+        total.maxError = qMax(total.maxError, r.maxError);
+    }
+    total.cost = costSum / routes.size();
+    total.meanError /= routes.size();
+    return total;
+}
+
+QVector<EvalResult> Tuner::evaluateBatch(const QVector<ControllerParams> &batch)
+{
+    double bound = bestCost;
+    QVector<EvalResult> results = QtConcurrent::blockingMapped<QVector<EvalResult>>(
+        batch, [this, bound](const ControllerParams &params) {
+            return evaluateAll(params, bound);
+        });
+
+    for (int i = 0; i < batch.size(); i++) {
+        TunerEntry entry;
+        entry.params = batch[i];
+        entry.result = results[i];
+        entries.append(entry);
+        // 剪枝结果的代价只是下界，不用于更新上界
+        if (results[i].finished) bestCost = qMin(bestCost, results[i].cost);
+    }
+    return results;
+}
+
+void Tuner::runGrid(int steps)
+{
+    steps = qMax(steps, 2);
+    qint64 total = 1;
+    for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) total *= steps;
+
+    QVector<ControllerParams> batch;
+    batch.reserve(BATCH_SIZE);
+    for (qint64 n = 0; n < total; n++) {
+        // 把序号拆成各参数的网格下标
+        double unit[CONTROLLER_PARAM_COUNT];
+        qint64 rest = n;
+        for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+            unit[i] = double(rest % steps) / (steps - 1);
+            rest /= steps;
+        }
+        batch.append(fromUnit(unit));
+
+        if (batch.size() >= BATCH_SIZE || n == total - 1) {
+            evaluateBatch(batch);
+            batch.clear();
+        }
+    }
+}
+
+void Tuner::runRandom(int evals)
+{
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    QVector<ControllerParams> batch;
+    batch.reserve(BATCH_SIZE);
+    for (int n = 0; n < evals; n++) {
+        double unit[CONTROLLER_PARAM_COUNT];
+        for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) unit[i] = uniform(rng);
+        batch.append(fromUnit(unit));
+
+        if (batch.size() >= BATCH_SIZE || n == evals - 1) {
+            evaluateBatch(batch);
+            batch.clear();
+        }
+    }
+}
+
+void Tuner::runEvolution(int evals)
+{
+    // 种群大小随核数增加，保证每代都能占满所有线程；评估次数不足一代时缩小种群，至少跑一代
+    const int lambda = qBound(2, qMax(16, QThread::idealThreadCount() * 4), qMax(2, evals));
+    const int mu = lambda / 2;
+    const double LEARNING_RATE = 0.2; // 方差更新速率
+
+    // 对数排名权重
+    QVector<double> weights(mu);
+    double weightSum = 0;
+    for (int i = 0; i < mu; i++) {
+        weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+        weightSum += weights[i];
+    }
+    for (int i = 0; i < mu; i++) weights[i] /= weightSum;
+
+    // 从界面默认参数出发
+    double mean[CONTROLLER_PARAM_COUNT];
+    double sigma[CONTROLLER_PARAM_COUNT];
+    toUnit(defaultControllerParams(), mean);
+    for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) sigma[i] = 0.3;
+
+    std::normal_distribution<double> normal(0.0, 1.0);
+    QVector<QVector<double>> samples(lambda, QVector<double>(CONTROLLER_PARAM_COUNT));
+    QVector<ControllerParams> batch(lambda);
+
+    for (int done = 0; done + lambda <= evals; done += lambda) {
+        // 1. 采样新一代
+        for (int k = 0; k < lambda; k++) {
+            for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+                samples[k][i] = qBound(0.0, mean[i] + sigma[i] * normal(rng), 1.0);
+            }
+            batch[k] = fromUnit(samples[k].constData());
+        }
+
+        // 2. 并行评估并按代价排序
+        QVector<EvalResult> results = evaluateBatch(batch);
+        QVector<int> order(lambda);
+        for (int k = 0; k < lambda; k++) order[k] = k;
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return results[a].cost < results[b].cost;
+        });
+
+        // 3. 用前mu个个体更新均值和各维方差
+        for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+            double newMean = 0;
+            double variance = 0;
+            for (int r = 0; r < mu; r++) {
+                double x = samples[order[r]][i];
+                newMean += weights[r] * x;
+                variance += weights[r] * (x - mean[i]) * (x - mean[i]);
+            }
+            mean[i] = newMean;
+            sigma[i] = std::sqrt((1 - LEARNING_RATE) * sigma[i] * sigma[i] + LEARNING_RATE * variance);
+            sigma[i] = qBound(1e-3, sigma[i], 0.5);
+        }
+    }
+}
+
+void Tuner::writeReport(QTextStream &out, int top) const
+{
+    QVector<TunerEntry> ranked = entries;
+    top = qMin(top, ranked.size());
+    // 剪枝结果的代价只是下界，排在完整评估的结果之后
+    std::partial_sort(ranked.begin(), ranked.begin() + top, ranked.end(),
+                      [](const TunerEntry &a, const TunerEntry &b) {
+        if (a.result.pruned != b.result.pruned) return !a.result.pruned;
+        return a.result.cost < b.result.cost;
+    });
+
+    out << "rank,cost,meanError,maxError,frames,finished,pruned";
+    for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) out << "," << controllerParamName(i);
+    out << "\n";
+
+    for (int r = 0; r < top; r++) {
+        const TunerEntry &entry = ranked[r];
+        out << (r + 1) << ","
+            << QString::number(entry.result.cost, 'f', 4) << ","
+            << QString::number(entry.result.meanError, 'f', 3) << ","
+            << QString::number(entry.result.maxError, 'f', 3) << ","
+            << entry.result.frames << ","
+            << (entry.result.finished ? 1 : 0) << ","
+            << (entry.result.pruned ? 1 : 0);
+        for (int i = 0; i < CONTROLLER_PARAM_COUNT; i++) {
+            out << "," << QString::number(controllerParam(entry.params, i), 'f', 3);
+        }
+        out << "\n";
+    }
+}
+
+int runTuner(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("路径跟踪控制参数调优");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"tune", "搜索方法：grid、random或es", "method"},
+        {"evals", "评估次数（random/es）", "n", "10000"},
+        {"steps", "网格搜索每个参数的取值个数", "n", "6"},
+        {"figure8-size", "8字形路线大小", "size", "300"},
+        {"image", "加入图片中识别到的路线（可多次指定）", "file"},
+        {"report", "报告输出文件（默认输出到终端）", "file"},
+        {"top", "报告中保留的结果数", "n", "20"},
+        {"seed", "随机数种子", "n", "1"}
+    });
+    parser.process(arguments);
+
+    // 准备评估路线：8字形 + 图片路线
+    QVector<QVector<QPointF>> routes;
+    routes.append(Simulator::figure8Points(parser.value("figure8-size").toDouble()));
+    for (const QString &file : parser.values("image")) {
+        cv::Mat image = cv::imread(file.toStdString(), cv::IMREAD_GRAYSCALE);
+        if (image.empty()) {
+            qWarning() << "图片加载失败:" << file;
+            return 1;
+        }
+        routes.append(RouteLibrary::extractCurvePoints(image, RouteLibrary::MIN_STROKE_AREA));
+    }
+
+    Tuner tuner(routes, parser.value("seed").toUInt());
+    QString method = parser.value("tune");
+    int evals = parser.value("evals").toInt();
+    if (method == "es" && evals < 2) {
+        qWarning() << "进化策略至少需要2次评估（--evals）";
+        return 1;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    if (method == "grid") {
+        tuner.runGrid(parser.value("steps").toInt());
+    } else if (method == "random") {
+        tuner.runRandom(evals);
+    } else if (method == "es") {
+        tuner.runEvolution(evals);
+    } else {
+        qWarning() << "未知搜索方法:" << method;
+        return 1;
+    }
+    double seconds = elapsed.elapsed() / 1000.0;
+
+    QFile file(parser.value("report"));
+    QTextStream out(stdout);
+    if (parser.isSet("report")) {
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "无法写入报告:" << file.fileName();
+            return 1;
+        }
+        out.setDevice(&file);
+    }
+
+    out << "# method=" << method << " routes=" << routes.size()
+        << " evaluations=" << tuner.evaluations()
+        << " seconds=" << QString::number(seconds, 'f', 1)
+        << " threads=" << QThread::idealThreadCount() << "\n";
+    tuner.writeReport(out, parser.value("top").toInt());
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <QVector>
+#include <QPointF>
+#include <QStringList>
+#include <QTextStream>
+#include <random>
+#include "simulator.h"
+
+// 无界面参数调优：在多条路线上并行评估控制参数，输出排名报告
+class Tuner
+{
+public:
+    Tuner(const QVector<QVector<QPointF>> &routes, quint32 seed);
+
+    // 网格搜索：每个参数取steps个等间距值
+    void runGrid(int steps);
+    // 随机搜索
+    void runRandom(int evals);
+    // 对角协方差的进化策略（简化版CMA-ES）
+    void runEvolution(int evals);
+
+    int evaluations() const { return entries.size(); }
+
+    // 按代价从小到大输出前top个结果（CSV）
+    void writeReport(QTextStream &out, int top) const;
+
+private:
+    typedef struct
+    {
+        ControllerParams params;
+        EvalResult result;
+    } TunerEntry;
+
+    // 在所有路线上评估，代价取平均
+    EvalResult evaluateAll(const ControllerParams &params, double costBound) const;
+    // 并行评估一批参数，结果追加到entries
+    QVector<EvalResult> evaluateBatch(const QVector<ControllerParams> &batch);
+
+    // 归一化坐标[0,1]与实际参数的转换
+    ControllerParams fromUnit(const double *unit) const;
+    void toUnit(const ControllerParams &params, double *unit) const;
+
+    QVector<QVector<QPointF>> routes;
+    QVector<TunerEntry> entries;
+    double bestCost;
+    std::mt19937 rng;
+
+    // 每批评估的参数组数（批与批之间更新剪枝上界）
+    const int BATCH_SIZE = 4096;
+};
+
+// 命令行入口：autoDrive --tune grid|random|es [选项]
+int runTuner(const QStringList &arguments);
+
+#endif // TUNER_H